@@ -33,8 +33,8 @@ int main() try
     
     for(uint i = 0; i < controls.size(); i++) {
 		v4l2isp::SelectNewValue(&controls[i]);
-		camera->SetControl(controls[i]);
 	}
+    camera->SetControls(controls);
     
     uint32_t frameRate = v4l2isp::SelectFrameRate();
 	camera->SetFrameRate(frameRate);
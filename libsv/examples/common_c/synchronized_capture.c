@@ -0,0 +1,73 @@
+#include "synchronized_capture.h"
+
+#define SYNCHRONIZATION_MAX_ATTEMPTS 30
+
+static uint64_t TimestampUs(const IImage *image)
+{
+    return image->timestamp.s * 1000000 + image->timestamp.us;
+}
+
+static void ReturnImagesExcept(ICamera **cameras, int size, IImage *images, int skipped)
+{
+    int i;
+
+    for (i = 0; i < size; i++) {
+        if (i != skipped) {
+            sv_camera_ReturnImage(cameras[i], images[i]);
+        }
+    }
+}
+
+bool GetSynchronizedImages(ICamera **cameras, int size, uint64_t toleranceUs, IImage *images)
+{
+    uint32_t attempt;
+    uint64_t newestUs;
+    bool synchronized;
+    int i;
+
+    for (i = 0; i < size; i++) {
+        images[i] = sv_camera_GetImage(cameras[i]);
+        if (images[i].data == NULL) {
+            ReturnSynchronizedImages(cameras, i, images);
+            return false;
+        }
+    }
+
+    for (attempt = 0; attempt < SYNCHRONIZATION_MAX_ATTEMPTS; attempt++) {
+
+        newestUs = 0;
+        for (i = 0; i < size; i++) {
+            if (TimestampUs(&images[i]) > newestUs) {
+                newestUs = TimestampUs(&images[i]);
+            }
+        }
+
+        synchronized = true;
+        for (i = 0; i < size; i++) {
+            if (newestUs - TimestampUs(&images[i]) <= toleranceUs) {
+                continue;
+            }
+
+            synchronized = false;
+            sv_camera_ReturnImage(cameras[i], images[i]);
+            images[i] = sv_camera_GetImage(cameras[i]);
+
+            if (images[i].data == NULL) {
+                ReturnImagesExcept(cameras, size, images, i);
+                return false;
+            }
+        }
+
+        if (synchronized) {
+            return true;
+        }
+    }
+
+    ReturnSynchronizedImages(cameras, size, images);
+    return false;
+}
+
+void ReturnSynchronizedImages(ICamera **cameras, int size, IImage *images)
+{
+    ReturnImagesExcept(cameras, size, images, -1);
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "sv/sv.h"
+
+/**
+ * Fills images with one image per camera, in camera list order, with all timestamps 
+ * within toleranceUs of each other. Frames that fall behind are returned to their 
+ * camera and replaced by the next one. Returns false if a camera fails to deliver 
+ * a valid image or no match is found, in which case no images are held.
+ */
+bool GetSynchronizedImages(ICamera **cameras, int size, uint64_t toleranceUs, IImage *images);
+
+void ReturnSynchronizedImages(ICamera **cameras, int size, IImage *images);
\ No newline at end of file
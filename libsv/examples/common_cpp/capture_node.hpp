@@ -2,7 +2,12 @@
 
 #include "node.hpp"
 #include "fps_measurer.hpp"
+#include "stream_stats.hpp"
+#include "latency_histogram.hpp"
 #include "sv/sv.h"
+#include <functional>
+#include <algorithm>
+#include <atomic>
 
 namespace common
 {
@@ -11,7 +16,8 @@ namespace common
     {
         public: 
 
-            explicit CaptureNode(ICamera *camera) : camera(camera)
+            explicit CaptureNode(ICamera *camera) 
+            : camera(camera), adaptiveBufferCount(false), droppingBufferCount(0), streamSequenceGaps(0), heldImages(0), peakHeldImages(0)
             {
 
             }
@@ -26,14 +32,70 @@ namespace common
                 return fpsMeasurer.GetFps();
             }
 
+            StreamStats GetStreamStats()
+            {
+                StreamStats stats = streamStats.GetStats();
+                stats.droppedFrames = GetDroppedOutputs();
+                return stats;
+            }
+
+            /**
+             * Time spent waiting in GetImage() and in ReturnImage(). 
+             * Recorded only while LatencyHistogram is enabled.
+             */
+            LatencyHistogram &GetImageLatency()
+            {
+                return getImageLatency;
+            }
+
+            LatencyHistogram &GetReturnImageLatency()
+            {
+                return returnImageLatency;
+            }
+
+            /**
+             * Callback is invoked on the capture thread as soon as a valid image
+             * is received, before it is handed over to the next node.
+             * It has to be set before Start() is called.
+             */
+            void SetFrameCallback(std::function<void(const IImage&)> callback)
+            {
+                frameCallback = callback;
+            }
+
+            /**
+             * When enabled, SV_API_BUFFERCOUNT is adjusted on every Start() based on the 
+             * previous stream. Buffer count grows if frames were skipped and shrinks to the 
+             * peak number of images held by the application plus a reserve for the driver,
+             * but never to a count that has already skipped frames.
+             */
+            void SetAdaptiveBufferCount(bool enable)
+            {
+                adaptiveBufferCount = enable;
+            }
+
             using Node::ReturnOutput;
 
         protected:
 
             void PerformAction(IImage &output) override
             {
-                output = camera->GetImage();
+                {
+                    ScopedLatency latency(getImageLatency);
+                    output = camera->GetImage();
+                }
                 fpsMeasurer.FrameReceived();
+                streamStats.ImageReceived(output);
+
+                if (output.data != nullptr) {
+                    uint32_t held = ++heldImages;
+                    uint32_t peak = peakHeldImages;
+                    while (held > peak && !peakHeldImages.compare_exchange_weak(peak, held));
+                }
+
+                if (frameCallback && output.data != nullptr) {
+                    frameCallback(output);
+                }
             }
 
             void InitializeAction() override
@@ -42,6 +104,15 @@ namespace common
                 if (control) {
                     control->Set(1);
                 } 
+
+                if (adaptiveBufferCount) {
+                    AdaptBufferCount();
+                }
+
+                streamStats.StreamStarted();
+                streamSequenceGaps = streamStats.GetSequenceGaps();
+                peakHeldImages = heldImages.load();
+
                 camera->StartStream();
             }
 
@@ -52,11 +123,58 @@ namespace common
 
             void ReturnOutput(IImage &output) override
             {
+                if (output.data != nullptr) {
+                    --heldImages;
+                }
+                streamStats.ImageReturned(output);
+
+                ScopedLatency latency(returnImageLatency);
                 camera->ReturnImage(output);
             }
 
         private:
+            /**
+             * Buffers needed besides the ones held by the application: queued in the 
+             * driver, held by the tearing prevention mechanism and in transit.
+             */
+            static constexpr int64_t BUFFER_COUNT_RESERVE = 4;
+            static constexpr int64_t BUFFER_COUNT_STEP = 2;
+
             ICamera *camera;
             FpsMeasurer fpsMeasurer;
+            std::function<void(const IImage&)> frameCallback;
+
+            StreamStatsCollector streamStats;
+            LatencyHistogram getImageLatency;
+            LatencyHistogram returnImageLatency;
+
+            bool adaptiveBufferCount;
+            int64_t droppingBufferCount;
+            uint64_t streamSequenceGaps;
+            std::atomic<uint32_t> heldImages;
+            std::atomic<uint32_t> peakHeldImages;
+
+            void AdaptBufferCount()
+            {
+                IControl *control = camera->GetControl(SV_API_BUFFERCOUNT);
+                if (!control || peakHeldImages == 0) {
+                    return;
+                }
+
+                int64_t current = control->Get();
+                int64_t count;
+                if (streamStats.GetSequenceGaps() > streamSequenceGaps) {
+                    droppingBufferCount = std::max(droppingBufferCount, current);
+                    count = current + BUFFER_COUNT_STEP;
+                } else {
+                    count = std::min<int64_t>(current, peakHeldImages + BUFFER_COUNT_RESERVE);
+                    count = std::max(count, droppingBufferCount + 1);
+                }
+
+                count = std::max(control->GetMinValue(), std::min(control->GetMaxValue(), count));
+                if (count != current) {
+                    control->Set(count);
+                }
+            }
     };
 }
\ No newline at end of file
@@ -3,7 +3,7 @@
 namespace common
 {
 
-ImagePipeline::ImagePipeline(ICamera *camera) : camera(camera)
+ImagePipeline::ImagePipeline(ICamera *camera) : camera(camera), masterQueried(false), master(true)
 {
 
 }
@@ -37,7 +37,21 @@ std::string ImagePipeline::GetCleanName()
     return cleanName;
 }
 
+/**
+ * Operation mode is configured before the pipeline is started, so it is read from
+ * the camera only once. Start and stop ordering then always agree with each other.
+ */
 bool ImagePipeline::IsMaster()
+{
+    if (!masterQueried) {
+        master = QueryMaster();
+        masterQueried = true;
+    }
+
+    return master;
+}
+
+bool ImagePipeline::QueryMaster()
 {
     auto controls = camera->GetControlList();
 
@@ -20,7 +20,10 @@ namespace common
             virtual void ReturnImage() = 0;
         
         private:
+            bool QueryMaster();
+
             ICamera* camera;
             std::string name, cleanName;
+            bool masterQueried, master;
     };
 }
\ No newline at end of file
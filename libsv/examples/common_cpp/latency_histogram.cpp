@@ -0,0 +1,108 @@
+#include "latency_histogram.hpp"
+
+namespace common
+{
+
+std::atomic<bool> LatencyHistogram::enabled(false);
+
+LatencyHistogram::LatencyHistogram() : count(0)
+{
+    Reset();
+}
+
+LatencyHistogram::~LatencyHistogram()
+{
+
+}
+
+void LatencyHistogram::SetEnabled(bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool LatencyHistogram::IsEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Record(Clock::duration latency)
+{
+    auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    if (latencyUs < 0) {
+        latencyUs = 0;
+    }
+
+    buckets[GetBucketIndex(latencyUs)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Reset()
+{
+    for (auto &bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetCount()
+{
+    return count.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the upper bound of the bucket containing the requested percentile (e.g. 99.9),
+ * or 0 if nothing was recorded.
+ */
+uint64_t LatencyHistogram::GetPercentileUs(double percentile)
+{
+    uint64_t total = GetCount();
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(total * percentile / 100.0);
+    if (target == 0) {
+        target = 1;
+    }
+
+    uint64_t accumulated = 0;
+    for (uint32_t i = 0; i < BUCKETS; ++i) {
+        accumulated += buckets[i].load(std::memory_order_relaxed);
+        if (accumulated >= target) {
+            return GetBucketUpperValueUs(i);
+        }
+    }
+
+    return GetBucketUpperValueUs(BUCKETS - 1);
+}
+
+/**
+ * Values below SUB_BUCKETS map linearly to the first buckets. Larger values are split by
+ * the position of their highest bit and the next SUB_BUCKET_BITS bits below it.
+ */
+uint32_t LatencyHistogram::GetBucketIndex(uint64_t valueUs)
+{
+    if (valueUs < SUB_BUCKETS) {
+        return valueUs;
+    }
+
+    uint32_t highestBit = 63 - __builtin_clzll(valueUs);
+    uint32_t shift = highestBit - SUB_BUCKET_BITS;
+    uint32_t subBucket = (valueUs >> shift) & (SUB_BUCKETS - 1);
+
+    return (shift + 1) * SUB_BUCKETS + subBucket;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperValueUs(uint32_t index)
+{
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+
+    uint32_t shift = index / SUB_BUCKETS - 1;
+    uint64_t subBucket = index % SUB_BUCKETS;
+
+    return (((SUB_BUCKETS + subBucket + 1) << shift) - 1);
+}
+
+}
\ No newline at end of file
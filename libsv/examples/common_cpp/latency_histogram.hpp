@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace common
+{
+    /**
+     * Fixed-bucket latency histogram that can be updated and read from any thread without locks.
+     * 
+     * Buckets are logarithmic with 8 linear sub-buckets per power of two microseconds, so 
+     * percentiles are reported with at most 12.5% error. Recording is globally switched off
+     * by default and costs a single relaxed load when disabled.
+     */
+    class LatencyHistogram
+    {
+        public:
+            using Clock = std::chrono::steady_clock;
+
+            LatencyHistogram();
+            ~LatencyHistogram();
+
+            static void SetEnabled(bool enable);
+            static bool IsEnabled();
+
+            void Record(Clock::duration latency);
+            void Reset();
+
+            uint64_t GetCount();
+            uint64_t GetPercentileUs(double percentile);
+
+        private:
+            static constexpr uint32_t SUB_BUCKET_BITS = 3;
+            static constexpr uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+            static constexpr uint32_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+            static std::atomic<bool> enabled;
+
+            std::atomic<uint64_t> buckets[BUCKETS];
+            std::atomic<uint64_t> count;
+
+            static uint32_t GetBucketIndex(uint64_t valueUs);
+            static uint64_t GetBucketUpperValueUs(uint32_t index);
+    };
+
+    /**
+     * Records the lifetime of the object into a histogram if histograms are enabled.
+     */
+    class ScopedLatency
+    {
+        public:
+            explicit ScopedLatency(LatencyHistogram &histogram) 
+            : histogram(histogram), active(LatencyHistogram::IsEnabled())
+            {
+                if (active) {
+                    start = LatencyHistogram::Clock::now();
+                }
+            }
+
+            ~ScopedLatency()
+            {
+                if (active) {
+                    histogram.Record(LatencyHistogram::Clock::now() - start);
+                }
+            }
+
+        private:
+            LatencyHistogram &histogram;
+            bool active;
+            LatencyHistogram::Clock::time_point start;
+    };
+}
\ No newline at end of file
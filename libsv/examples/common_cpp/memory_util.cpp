@@ -0,0 +1,36 @@
+#include "memory_util.hpp"
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace common
+{
+
+bool PrewarmMemory(void *data, size_t length, bool lock)
+{
+    if (data == nullptr || length == 0) {
+        return false;
+    }
+
+    const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    volatile char *bytes = static_cast<volatile char*>(data);
+    for (size_t offset = 0; offset < length; offset += pageSize) {
+        bytes[offset] = bytes[offset];
+    }
+    bytes[length - 1] = bytes[length - 1];
+
+    if (lock) {
+        return ::mlock(data, length) == 0;
+    }
+
+    return true;
+}
+
+void UnlockMemory(void *data, size_t length)
+{
+    if (data != nullptr && length != 0) {
+        ::munlock(data, length);
+    }
+}
+
+}
\ No newline at end of file
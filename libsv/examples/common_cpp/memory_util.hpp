@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace common
+{
+    /**
+     * Touches every page of the buffer so the first frame does not pay for page faults.
+     * With lock set, pages are also locked in memory. Returns false if locking failed.
+     */
+    bool PrewarmMemory(void *data, size_t length, bool lock);
+    void UnlockMemory(void *data, size_t length);
+}
\ No newline at end of file
@@ -6,6 +6,10 @@
 #include <condition_variable>
 #include <iostream>
 #include <atomic>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "thread_util.hpp"
 
 namespace common
 {
@@ -14,7 +18,8 @@ namespace common
 
         public:
 
-            Node() : nodeActive(false), nodeAlive(true), outputInitialized(false), outputReady(false)
+            Node() : nodeActive(false), nodeAlive(true), outputInitialized(false), 
+                activeIndex(0), readyState(1), availableIndex(2), consumerWaiting(false), eventFd(-1), droppedOutputs(0), threadId(0)
             {
                 nodeThread = std::thread(&Node::NodeThread, this);
             }
@@ -28,6 +33,10 @@ namespace common
                 if (nodeThread.joinable()) {
                     nodeThread.join();
                 }
+
+                if (eventFd >= 0) {
+                    ::close(eventFd);
+                }
             }
 
             void Start()
@@ -52,28 +61,94 @@ namespace common
 
             Output GetOutputBlocking() 
             { 
-                std::unique_lock<std::mutex> lock(outputMutex);
-                outputCondition.wait(lock, [&]{ return outputReady || !nodeAlive; } );
+                if (!IsOutputReady()) {
+                    std::unique_lock<std::mutex> lock(outputMutex);
+                    consumerWaiting = true;
+                    outputCondition.wait(lock, [&]{ return IsOutputReady() || !nodeAlive; } );
+                    consumerWaiting = false;
+                }
 
                 MakeOutputAvailable();
 
-                return availableOutput;
+                return outputs[availableIndex];
             }
 
             bool GetOutputNonBlocking(Output &output)
             {
-                if (outputReady) {
-                    MakeOutputAvailable();
-                    output = availableOutput;
-                    return true;
+                if (!IsOutputReady()) {
+                    /**
+                     * A late eventfd_write() from the producer can leave the fd readable
+                     * after its output was already taken. Clear it so level-triggered
+                     * pollers do not spin, then check again for an output published meanwhile.
+                     */
+                    DrainEventFd();
+                    if (!IsOutputReady()) {
+                        return false;
+                    }
                 }
 
-                return false;
+                MakeOutputAvailable();
+                output = outputs[availableIndex];
+                return true;
             }
 
             void ReturnOutput()
             {
-                ReturnOutput(availableOutput);
+                ReturnOutput(outputs[availableIndex]);
+            }
+
+            /**
+             * Node thread tuning. Affinity takes a list of CPU indices, scheduling takes
+             * a policy (SCHED_OTHER, SCHED_FIFO, SCHED_RR) and priority.
+             */
+            bool SetThreadAffinity(const std::vector<int> &cpus)
+            {
+                return common::SetThreadAffinity(nodeThread, cpus);
+            }
+
+            bool SetThreadScheduling(int policy, int priority)
+            {
+                return common::SetThreadScheduling(nodeThread, policy, priority);
+            }
+
+            bool SetThreadName(const std::string &name)
+            {
+                return common::SetThreadName(nodeThread, name);
+            }
+
+            /**
+             * Returns the kernel thread id of the node thread, or 0 if it has not started yet.
+             */
+            pid_t GetThreadId()
+            {
+                return threadId;
+            }
+
+            /**
+             * Only the newest output is kept for the consumer. Outputs that were replaced
+             * before the consumer fetched them are returned immediately and counted here.
+             */
+            uint64_t GetDroppedOutputs()
+            {
+                return droppedOutputs;
+            }
+
+            /**
+             * Returns a non-blocking eventfd that is readable while an output is ready.
+             * It allows a single thread to wait on multiple nodes using poll/epoll 
+             * and then fetch the output with GetOutputNonBlocking().
+             */
+            int GetEventFd()
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                if (eventFd < 0) {
+                    eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                    if (IsOutputReady()) {
+                        ::eventfd_write(eventFd, 1);
+                    }
+                }
+
+                return eventFd;
             }
 
         protected:
@@ -113,23 +188,38 @@ namespace common
             std::mutex threadMutex;
             std::condition_variable threadCondition;
 
+            /**
+             * Outputs are handed over from the node thread to the consumer through a lock-free 
+             * triple buffer. The node thread owns the active slot, the consumer owns the available 
+             * slot and the ready slot is exchanged atomically. The mutex and condition variable 
+             * are only used when the consumer is blocked waiting for a new output.
+             */
+            static constexpr uint8_t OUTPUT_INDEX_MASK = 0x3;
+            static constexpr uint8_t OUTPUT_FRESH = 0x4;
+
             bool outputInitialized;
-            bool outputReady;
-            Output availableOutput;
-            Output readyOutput;
-            Output activeOutput;
+            Output outputs[3];
+            uint8_t activeIndex;
+            std::atomic<uint8_t> readyState;
+            uint8_t availableIndex;
+            std::atomic<bool> consumerWaiting;
             std::mutex outputMutex;
             std::condition_variable outputCondition;
+            std::atomic<int> eventFd;
+            std::atomic<uint64_t> droppedOutputs;
+            std::atomic<pid_t> threadId;
 
             void NodeThread() 
             {
+                threadId = GetCurrentThreadId();
+
                 while (nodeAlive) {
         
                     std::unique_lock<std::mutex> lock(threadMutex);
                     threadCondition.wait(lock, [&]{ return nodeActive || !nodeAlive; } );
                     if (!nodeAlive) return;
 
-                    PerformAction(activeOutput);
+                    PerformAction(outputs[activeIndex]);
 
                     SetOutput();
 
@@ -139,19 +229,31 @@ namespace common
                 }
             }
 
+            bool IsOutputReady()
+            {
+                return readyState & OUTPUT_FRESH;
+            }
+
             void SetOutput()
             {
-                std::unique_lock<std::mutex> lock(outputMutex);
+                uint8_t previous = readyState.exchange(activeIndex | OUTPUT_FRESH);
+                activeIndex = previous & OUTPUT_INDEX_MASK;
 
-                if (outputReady) {
-                    ReturnOutput(readyOutput);
+                if (previous & OUTPUT_FRESH) {
+                    ReturnOutput(outputs[activeIndex]);
+                    droppedOutputs.fetch_add(1, std::memory_order_relaxed);
+                    return;
                 }
 
-                std::swap(readyOutput, activeOutput);
-                outputReady = true;
-            
-                lock.unlock();
-                outputCondition.notify_all();
+                int fd = eventFd;
+                if (fd >= 0) {
+                    ::eventfd_write(fd, 1);
+                }
+
+                if (consumerWaiting) {
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    outputCondition.notify_all();
+                }
             }
 
             void ReinitializeOutput()
@@ -165,24 +267,37 @@ namespace common
 
             void DeinitializeOutput()
             {
-                DeinitializeOutput(availableOutput);
-                DeinitializeOutput(readyOutput);
-                DeinitializeOutput(activeOutput);
+                for (auto &output : outputs) {
+                    DeinitializeOutput(output);
+                }
                 outputInitialized = false;
             }
 
             void InitializeOutput()
             {
-                InitializeOutput(availableOutput);
-                InitializeOutput(readyOutput);
-                InitializeOutput(activeOutput);
+                for (auto &output : outputs) {
+                    InitializeOutput(output);
+                }
                 outputInitialized = true;
             }
 
+            void DrainEventFd()
+            {
+                int fd = eventFd;
+                if (fd >= 0) {
+                    eventfd_t value;
+                    ::eventfd_read(fd, &value);
+                }
+            }
+
+            /**
+             * The eventfd is drained before the ready slot is taken, so an output
+             * published in between is signaled again and never missed.
+             */
             void MakeOutputAvailable()
             {
-                std::swap(availableOutput, readyOutput);
-                outputReady = false;
+                DrainEventFd();
+                availableIndex = readyState.exchange(availableIndex) & OUTPUT_INDEX_MASK;
             }
     };
 }
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "parallel_image_processor.hpp"
+#include "thread_util.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace common
+{
+
+ParallelImageProcessor::ParallelImageProcessor(uint32_t threadCount, const std::vector<int> &cpus)
+: running(true), generation(0), activeWorkers(0), input(nullptr), output(nullptr), firstStripe(), 
+  stripeRows(0), stripeCount(0), nextStripe(0), failed(false)
+{
+    for (uint32_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ParallelImageProcessor::WorkerThread, this);
+        SetThreadName(workers.back(), "sv_process_" + std::to_string(i));
+        if (!cpus.empty()) {
+            SetThreadAffinity(workers.back(), { cpus[i % cpus.size()] });
+        }
+    }
+}
+
+ParallelImageProcessor::~ParallelImageProcessor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    workAvailable.notify_all();
+
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+bool ParallelImageProcessor::Process(const IImage &input, IProcessedImage &output)
+{
+    if (workers.empty() || input.data == nullptr || output.data == nullptr || 
+        input.stride == 0 || input.height != output.height) {
+        return sv::ProcessImage(input, output, SV_ALGORITHM_AUTODETECT);
+    }
+
+    Format format(input.pixelFormat, input.width, input.height, input.stride);
+    if (unsupportedFormats.count(format) != 0) {
+        return sv::ProcessImage(input, output, SV_ALGORITHM_AUTODETECT);
+    }
+
+    uint32_t rows = std::max<uint32_t>(2, (STRIPE_BYTES / input.stride) & ~1u);
+    uint32_t count = (input.height + rows - 1) / rows;
+    if (count < 2) {
+        return sv::ProcessImage(input, output, SV_ALGORITHM_AUTODETECT);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->input = &input;
+        this->output = &output;
+        stripeRows = rows;
+        stripeCount = count;
+        nextStripe = 0;
+        failed = false;
+        activeWorkers = workers.size();
+        ++generation;
+    }
+    workAvailable.notify_all();
+
+    ProcessStripes();
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        workDone.wait(lock, [this]() { return activeWorkers == 0; });
+    }
+
+    if (failed) {
+        unsupportedFormats.insert(format);
+        std::cout << "Striped processing failed for " << input.width << "x" << input.height 
+                  << " frames, processing them whole from now on." << std::endl;
+        return sv::ProcessImage(input, output, SV_ALGORITHM_AUTODETECT);
+    }
+
+    output.timestamp = firstStripe.timestamp;
+    output.embeddedDataWidth = firstStripe.embeddedDataWidth;
+    output.embeddedDataHeight = firstStripe.embeddedDataHeight;
+
+    return true;
+}
+
+void ParallelImageProcessor::WorkerThread()
+{
+    uint64_t processedGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [&]() { return !running || generation != processedGeneration; });
+            if (!running) {
+                return;
+            }
+            processedGeneration = generation;
+        }
+
+        ProcessStripes();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--activeWorkers == 0) {
+                workDone.notify_one();
+            }
+        }
+    }
+}
+
+/**
+ * Stripes are processed independently, which assumes the platform kernels inside libsv 
+ * only ever look at the rows they are given. This has not been verified against the 
+ * library itself, so a stripe failure disables striping for that format.
+ */
+void ParallelImageProcessor::ProcessStripes()
+{
+    uint32_t stripe;
+    while ((stripe = nextStripe.fetch_add(1)) < stripeCount) {
+        uint32_t row = stripe * stripeRows;
+        uint32_t rows = std::min(stripeRows, input->height - row);
+
+        IImage inputStripe = *input;
+        inputStripe.data = static_cast<uint8_t*>(input->data) + static_cast<size_t>(row) * input->stride;
+        inputStripe.height = rows;
+        inputStripe.length = rows * input->stride;
+
+        IProcessedImage outputStripe = *output;
+        outputStripe.data = static_cast<uint8_t*>(output->data) + static_cast<size_t>(row) * output->stride;
+        outputStripe.height = rows;
+        outputStripe.length = rows * output->stride;
+
+        /**
+         * The first stripe copies the embedded data into the output's own embedded data
+         * buffer, which has to be allocated (sv::AllocateProcessedImage or ProcessedImagePool).
+         */
+        if (stripe != 0) {
+            inputStripe.embeddedData = nullptr;
+            inputStripe.embeddedDataWidth = 0;
+            inputStripe.embeddedDataHeight = 0;
+            outputStripe.embeddedData = nullptr;
+            outputStripe.embeddedDataWidth = 0;
+            outputStripe.embeddedDataHeight = 0;
+        }
+
+        if (!sv::ProcessImage(inputStripe, outputStripe, SV_ALGORITHM_AUTODETECT)) {
+            failed = true;
+        }
+
+        if (stripe == 0) {
+            firstStripe = outputStripe;
+        }
+    }
+}
+
+}
\ No newline at end of file
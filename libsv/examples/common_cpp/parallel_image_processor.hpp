@@ -0,0 +1,65 @@
+#pragma once
+
+#include "sv/sv.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace common
+{
+    /**
+     * Runs sv::ProcessImage() on horizontal stripes of the frame using a persistent pool of 
+     * worker threads. The calling thread processes stripes as well. Stripes are sized to fit 
+     * the cache and have an even number of rows so Bayer patterns are never split.
+     * 
+     * Only the first stripe carries the embedded data. If any stripe fails, 
+     * the whole frame is processed again on the calling thread and striping is 
+     * turned off for frames of that format.
+     * 
+     * Striping assumes the libsv processing kernels are row-independent, 
+     * which cannot be checked from this tree.
+     */
+    class ParallelImageProcessor
+    {
+        public:
+            /**
+             * Workers are pinned round-robin to the given CPUs, if any.
+             */
+            explicit ParallelImageProcessor(uint32_t threadCount, const std::vector<int> &cpus = std::vector<int>());
+            ~ParallelImageProcessor();
+
+            ParallelImageProcessor(const ParallelImageProcessor&) = delete;
+            ParallelImageProcessor &operator=(const ParallelImageProcessor&) = delete;
+
+            bool Process(const IImage &input, IProcessedImage &output);
+
+        private:
+            using Format = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>;
+
+            static constexpr uint32_t STRIPE_BYTES = 256 * 1024;
+
+            void WorkerThread();
+            void ProcessStripes();
+
+            std::vector<std::thread> workers;
+            std::mutex mutex;
+            std::condition_variable workAvailable;
+            std::condition_variable workDone;
+            bool running;
+            uint64_t generation;
+            uint32_t activeWorkers;
+
+            const IImage *input;
+            IProcessedImage *output;
+            IProcessedImage firstStripe;
+            uint32_t stripeRows;
+            uint32_t stripeCount;
+            std::atomic<uint32_t> nextStripe;
+            std::atomic<bool> failed;
+            std::set<Format> unsupportedFormats;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "processed_image_pool.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+
+namespace common
+{
+
+ProcessedImagePool &ProcessedImagePool::GetInstance()
+{
+    static ProcessedImagePool pool;
+    return pool;
+}
+
+ProcessedImagePool::ProcessedImagePool() : hugePages(false)
+{
+
+}
+
+ProcessedImagePool::~ProcessedImagePool()
+{
+    Clear();
+}
+
+void ProcessedImagePool::SetHugePages(bool enable)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    hugePages = enable;
+}
+
+IProcessedImage ProcessedImagePool::Acquire(const IImageInfo &imageInfo)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Key key = GetKey(imageInfo);
+    auto &images = freeImages[key];
+    if (!images.empty()) {
+        IProcessedImage image = images.back();
+        images.pop_back();
+        acquiredImages[image.data] = std::make_pair(key, image.embeddedData);
+        return image;
+    }
+
+    /**
+     * Output layout (length, stride) is decided by the library, 
+     * so it is taken from a single library allocation per format.
+     * Processing copies embedded data into a separate buffer that must always be present.
+     */
+    auto layout = layouts.find(key);
+    if (layout == layouts.end()) {
+        IProcessedImage image = sv::AllocateProcessedImage(imageInfo);
+        if (image.data == nullptr) {
+            throw std::bad_alloc();
+        }
+        sv::DeallocateProcessedImage(image);
+        image.data = nullptr;
+        image.embeddedData = nullptr;
+        layout = layouts.emplace(key, image).first;
+    }
+
+    IProcessedImage image = layout->second;
+    image.data = AllocateBuffer(image.length);
+    try {
+        image.embeddedData = AllocateBuffer(GetEmbeddedDataSize(image));
+    } catch (...) {
+        std::free(image.data);
+        throw;
+    }
+    acquiredImages[image.data] = std::make_pair(key, image.embeddedData);
+    return image;
+}
+
+void ProcessedImagePool::Release(IProcessedImage &image)
+{
+    if (image.data == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto acquired = acquiredImages.find(image.data);
+    if (acquired == acquiredImages.end()) {
+        return;
+    }
+
+    IProcessedImage released = layouts[acquired->second.first];
+    released.data = image.data;
+    released.embeddedData = acquired->second.second;
+    freeImages[acquired->second.first].push_back(released);
+    acquiredImages.erase(acquired);
+
+    image.data = nullptr;
+    image.embeddedData = nullptr;
+}
+
+void ProcessedImagePool::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (auto &images : freeImages) {
+        for (auto &image : images.second) {
+            std::free(image.data);
+            std::free(image.embeddedData);
+        }
+    }
+    freeImages.clear();
+}
+
+ProcessedImagePool::Key ProcessedImagePool::GetKey(const IImageInfo &imageInfo)
+{
+    return Key(imageInfo.length, imageInfo.width, imageInfo.height, imageInfo.pixelFormat, imageInfo.stride);
+}
+
+/**
+ * sv::ProcessImage() copies embedded data without a bound check, so the buffer
+ * is never smaller than what the library's own allocation reports.
+ */
+size_t ProcessedImagePool::GetEmbeddedDataSize(const IProcessedImage &layout)
+{
+    size_t reported = static_cast<size_t>(layout.embeddedDataWidth) * layout.embeddedDataHeight;
+    return reported > EMBEDDED_DATA_SIZE ? reported : size_t(EMBEDDED_DATA_SIZE);
+}
+
+void *ProcessedImagePool::AllocateBuffer(size_t length)
+{
+    bool useHugePages = hugePages && length >= HUGE_PAGE_SIZE;
+    size_t alignment = useHugePages ? HUGE_PAGE_SIZE : CACHE_LINE_SIZE;
+    size_t alignedLength = (length + alignment - 1) / alignment * alignment;
+
+    void *buffer = nullptr;
+    if (::posix_memalign(&buffer, alignment, alignedLength) != 0) {
+        throw std::bad_alloc();
+    }
+
+    if (useHugePages) {
+        ::madvise(buffer, alignedLength, MADV_HUGEPAGE);
+    }
+
+    return buffer;
+}
+
+}
\ No newline at end of file
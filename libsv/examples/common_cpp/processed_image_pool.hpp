@@ -0,0 +1,60 @@
+#pragma once
+
+#include "sv/sv.h"
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace common
+{
+    /**
+     * Recycles IProcessedImage buffers between nodes and stream restarts instead of 
+     * allocating a full frame each time. Buffers are 64-byte aligned and, when huge pages
+     * are enabled, aligned to and advised as transparent huge pages (best effort).
+     * 
+     * Images acquired from the pool have to be released to it and never passed 
+     * to sv::DeallocateProcessedImage().
+     */
+    class ProcessedImagePool
+    {
+        public:
+            static ProcessedImagePool &GetInstance();
+
+            ~ProcessedImagePool();
+
+            void SetHugePages(bool enable);
+
+            IProcessedImage Acquire(const IImageInfo &imageInfo);
+            void Release(IProcessedImage &image);
+
+            /**
+             * Frees all buffers that are currently not acquired.
+             */
+            void Clear();
+
+        private:
+            using Key = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+            static constexpr size_t CACHE_LINE_SIZE = 64;
+            static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+            /**
+             * Size of the embedded data buffer current libsv versions allocate. Only used 
+             * as a lower bound when the library does not report the embedded data geometry.
+             */
+            static constexpr size_t EMBEDDED_DATA_SIZE = 512 * 1024;
+
+            ProcessedImagePool();
+
+            static Key GetKey(const IImageInfo &imageInfo);
+            static size_t GetEmbeddedDataSize(const IProcessedImage &layout);
+            void *AllocateBuffer(size_t length);
+
+            std::mutex mutex;
+            bool hugePages;
+            std::map<Key, IProcessedImage> layouts;
+            std::map<Key, std::vector<IProcessedImage>> freeImages;
+            std::map<void*, std::pair<Key, void*>> acquiredImages;
+    };
+}
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "image_pipeline.hpp"
 #include "image_processor.hpp"
 #include "fps_measurer.hpp"
+#include "processed_image_pool.hpp"
+#include "latency_histogram.hpp"
 
 namespace common
 {
@@ -17,12 +19,20 @@ namespace common
             : ImagePipeline(camera), ImageProcessor(camera->GetImageInfo().pixelFormat), camera(camera)
             {
                 captureNode = std::unique_ptr<CaptureNode>(new CaptureNode(camera));
-                svImage = sv::AllocateProcessedImage(camera->GetImageInfo());
+                svImage = ProcessedImagePool::GetInstance().Acquire(camera->GetImageInfo());
             }
 
             ~SequentialImagePipeline()
             {
-                sv::DeallocateProcessedImage(svImage);
+                ProcessedImagePool::GetInstance().Release(svImage);
+            }
+
+            /**
+             * Time spent in sv::ProcessImage(). Recorded only while LatencyHistogram is enabled.
+             */
+            LatencyHistogram &GetProcessImageLatency()
+            {
+                return processImageLatency;
             }
 
             void Start() override
@@ -38,11 +48,16 @@ namespace common
             cv::UMat GetImage() override
             {
                 auto rawImage = captureNode->GetOutputBlocking();
-                while (rawImage.data == nullptr)
+                while (rawImage.data == nullptr) {
+                    captureNode->ReturnOutput();
                     rawImage = captureNode->GetOutputBlocking();
+                }
 
-                sv::ProcessImage(rawImage, svImage, SV_ALGORITHM_AUTODETECT);
-                camera->ReturnImage(rawImage);
+                {
+                    ScopedLatency latency(processImageLatency);
+                    sv::ProcessImage(rawImage, svImage, SV_ALGORITHM_AUTODETECT);
+                }
+                captureNode->ReturnOutput();
 
                 cv::UMat image;
                 this->ProcessImage(svImage, image);
@@ -61,5 +76,6 @@ namespace common
             std::unique_ptr<CaptureNode> captureNode;
             IProcessedImage svImage;
             FpsMeasurer fpsMeasurer;
+            LatencyHistogram processImageLatency;
     };
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "sv/sv.h"
+#include <atomic>
+#include <chrono>
+#include <limits>
+
+namespace common
+{
+    /**
+     * Cumulative counters describing the health of a single camera stream.
+     */
+    struct StreamStats
+    {
+        uint64_t framesDelivered;   /**< Valid images received from GetImage() */
+        uint64_t invalidImages;     /**< GetImage() calls that returned no image (e.g. timeout) */
+        uint64_t sequenceGaps;      /**< Images missing from the sequence number progression */
+        uint64_t droppedFrames;     /**< Images returned unprocessed because a newer one was available */
+        uint64_t holdTimeMinUs;     /**< Shortest time an image was held before ReturnImage() */
+        uint64_t holdTimeAvgUs;     /**< Average time an image was held before ReturnImage() */
+        uint64_t holdTimeMaxUs;     /**< Longest time an image was held before ReturnImage() */
+        uint64_t timeToFirstFrameUs;/**< Time from the last stream start until its first valid image */
+    };
+
+    /**
+     * Collects StreamStats without locks. Updates are made by the capture side, 
+     * GetStats() can be called from any thread as often as every frame.
+     */
+    class StreamStatsCollector
+    {
+        public:
+
+            StreamStatsCollector() 
+            : framesDelivered(0), invalidImages(0), sequenceGaps(0), lastImageId(0),
+              holdTimeMinUs(std::numeric_limits<uint64_t>::max()), holdTimeMaxUs(0), holdTimeTotalUs(0), holdCount(0),
+              timeToFirstFrameUs(0), firstFramePending(false)
+            {
+
+            }
+
+            void ImageReceived(const IImage &image)
+            {
+                if (image.data == nullptr) {
+                    invalidImages.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                framesDelivered.fetch_add(1, std::memory_order_relaxed);
+
+                if (lastImageId != 0 && image.id > lastImageId + 1) {
+                    sequenceGaps.fetch_add(image.id - lastImageId - 1, std::memory_order_relaxed);
+                }
+                lastImageId = image.id;
+
+                auto now = std::chrono::steady_clock::now();
+                if (firstFramePending) {
+                    firstFramePending = false;
+                    timeToFirstFrameUs.store(std::chrono::duration_cast<std::chrono::microseconds>(
+                        now - streamStartTime).count(), std::memory_order_relaxed);
+                }
+
+                if (image.bufferid < MAX_TRACKED_BUFFERS) {
+                    receiveTimes[image.bufferid] = now;
+                }
+            }
+
+            void ImageReturned(const IImage &image)
+            {
+                if (image.data == nullptr || image.bufferid >= MAX_TRACKED_BUFFERS) {
+                    return;
+                }
+
+                uint64_t holdTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - receiveTimes[image.bufferid]).count();
+
+                uint64_t min = holdTimeMinUs.load(std::memory_order_relaxed);
+                while (holdTimeUs < min && !holdTimeMinUs.compare_exchange_weak(min, holdTimeUs, std::memory_order_relaxed));
+
+                uint64_t max = holdTimeMaxUs.load(std::memory_order_relaxed);
+                while (holdTimeUs > max && !holdTimeMaxUs.compare_exchange_weak(max, holdTimeUs, std::memory_order_relaxed));
+
+                holdTimeTotalUs.fetch_add(holdTimeUs, std::memory_order_relaxed);
+                holdCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * Sequence tracking and time to first frame restart with the next stream.
+             * Has to be called just before the stream is started.
+             */
+            void StreamStarted()
+            {
+                lastImageId = 0;
+                streamStartTime = std::chrono::steady_clock::now();
+                firstFramePending = true;
+            }
+
+            uint64_t GetSequenceGaps()
+            {
+                return sequenceGaps.load(std::memory_order_relaxed);
+            }
+
+            StreamStats GetStats()
+            {
+                StreamStats stats = {};
+                stats.framesDelivered = framesDelivered.load(std::memory_order_relaxed);
+                stats.invalidImages = invalidImages.load(std::memory_order_relaxed);
+                stats.sequenceGaps = sequenceGaps.load(std::memory_order_relaxed);
+                stats.timeToFirstFrameUs = timeToFirstFrameUs.load(std::memory_order_relaxed);
+
+                uint64_t count = holdCount.load(std::memory_order_relaxed);
+                if (count != 0) {
+                    stats.holdTimeMinUs = holdTimeMinUs.load(std::memory_order_relaxed);
+                    stats.holdTimeAvgUs = holdTimeTotalUs.load(std::memory_order_relaxed) / count;
+                    stats.holdTimeMaxUs = holdTimeMaxUs.load(std::memory_order_relaxed);
+                }
+
+                return stats;
+            }
+
+        private:
+            static constexpr uint32_t MAX_TRACKED_BUFFERS = 64;
+
+            std::atomic<uint64_t> framesDelivered;
+            std::atomic<uint64_t> invalidImages;
+            std::atomic<uint64_t> sequenceGaps;
+            uint32_t lastImageId;
+
+            std::chrono::steady_clock::time_point receiveTimes[MAX_TRACKED_BUFFERS];
+            std::atomic<uint64_t> holdTimeMinUs;
+            std::atomic<uint64_t> holdTimeMaxUs;
+            std::atomic<uint64_t> holdTimeTotalUs;
+            std::atomic<uint64_t> holdCount;
+
+            std::chrono::steady_clock::time_point streamStartTime;
+            std::atomic<uint64_t> timeToFirstFrameUs;
+            bool firstFramePending;
+    };
+}
\ No newline at end of file
@@ -3,6 +3,12 @@
 #include "node.hpp"
 #include "sv/sv.h"
 #include "capture_node.hpp"
+#include "latency_histogram.hpp"
+#include "memory_util.hpp"
+#include "processed_image_pool.hpp"
+#include "parallel_image_processor.hpp"
+#include <memory>
+#include <set>
 
 namespace common
 {
@@ -10,7 +16,7 @@ namespace common
     {
         public:
 
-            explicit SvProcessingNode(CaptureNode &captureNode, ICamera *camera) : captureNode(captureNode), camera(camera)
+            explicit SvProcessingNode(CaptureNode &captureNode, ICamera *camera) : captureNode(captureNode), camera(camera), prewarm(false), lockMemory(false)
             {
 
             }
@@ -20,6 +26,39 @@ namespace common
 
             }
 
+            /**
+             * Time spent in sv::ProcessImage(). Recorded only while LatencyHistogram is enabled.
+             */
+            LatencyHistogram &GetProcessImageLatency()
+            {
+                return processImageLatency;
+            }
+
+            /**
+             * Pre-fault the output buffer when it is allocated, optionally locking it
+             * in memory, so the first processed frame is not delayed by page faults.
+             * It has to be set before Start() is called.
+             */
+            void SetPrewarm(bool enable, bool lock = false)
+            {
+                prewarm = enable;
+                lockMemory = lock;
+            }
+
+            /**
+             * Split each frame into stripes processed by the given number of worker threads
+             * in addition to the node thread. Zero processes frames on the node thread only.
+             * It has to be set before Start() is called.
+             */
+            void SetProcessingThreads(uint32_t threadCount, const std::vector<int> &cpus = std::vector<int>())
+            {
+                if (threadCount == 0) {
+                    parallelProcessor.reset();
+                } else {
+                    parallelProcessor.reset(new ParallelImageProcessor(threadCount, cpus));
+                }
+            }
+
             using Node::ReturnOutput;
 
         protected:
@@ -28,23 +67,39 @@ namespace common
             {
                 IImage image = captureNode.GetOutputBlocking();
                 if (image.data != nullptr) {
-                    sv::ProcessImage(image, output, SV_ALGORITHM_AUTODETECT);
+                    ScopedLatency latency(processImageLatency);
+                    if (parallelProcessor) {
+                        parallelProcessor->Process(image, output);
+                    } else {
+                        sv::ProcessImage(image, output, SV_ALGORITHM_AUTODETECT);
+                    }
                 }
                 captureNode.ReturnOutput();
             }
 
             void InitializeOutput(IProcessedImage &output) override
             {
-                output = sv::AllocateProcessedImage(camera->GetImageInfo());   
+                output = ProcessedImagePool::GetInstance().Acquire(camera->GetImageInfo());
+                if (prewarm && PrewarmMemory(output.data, output.length, lockMemory) && lockMemory) {
+                    lockedBuffers.insert(output.data);
+                }
             }
 
             void DeinitializeOutput(IProcessedImage &output) override
             {
-                sv::DeallocateProcessedImage(output);
+                if (lockedBuffers.erase(output.data) != 0) {
+                    UnlockMemory(output.data, output.length);
+                }
+                ProcessedImagePool::GetInstance().Release(output);
             }
 
         private:
             CaptureNode &captureNode;
             ICamera *camera;
+            LatencyHistogram processImageLatency;
+            std::unique_ptr<ParallelImageProcessor> parallelProcessor;
+            bool prewarm;
+            bool lockMemory;
+            std::set<void*> lockedBuffers;
     };
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "synchronized_capture.hpp"
+
+#include <algorithm>
+
+namespace common
+{
+
+namespace
+{
+    constexpr uint32_t SYNCHRONIZATION_MAX_ATTEMPTS = 30;
+
+    uint64_t TimestampUs(const IImage &image)
+    {
+        return image.timestamp.s * 1000000 + image.timestamp.us;
+    }
+}
+
+std::vector<IImage> GetSynchronizedImages(const ICameraList &cameras, uint64_t toleranceUs)
+{
+    std::vector<IImage> images;
+    images.reserve(cameras.size());
+
+    for (ICamera *camera : cameras) {
+        IImage image = camera->GetImage();
+        if (image.data == nullptr) {
+            ReturnSynchronizedImages(cameras, images);
+            return {};
+        }
+        images.push_back(image);
+    }
+
+    for (uint32_t attempt = 0; attempt < SYNCHRONIZATION_MAX_ATTEMPTS; ++attempt) {
+
+        auto newest = std::max_element(images.begin(), images.end(), 
+            [](const IImage &first, const IImage &second) { 
+                return TimestampUs(first) < TimestampUs(second); 
+            }
+        );
+        uint64_t newestUs = TimestampUs(*newest);
+
+        bool synchronized = true;
+        for (size_t i = 0; i < images.size(); ++i) {
+            if (newestUs - TimestampUs(images[i]) <= toleranceUs) {
+                continue;
+            }
+
+            synchronized = false;
+            cameras[i]->ReturnImage(images[i]);
+            images[i] = cameras[i]->GetImage();
+
+            if (images[i].data == nullptr) {
+                images.erase(images.begin() + i);
+                ICameraList remaining = cameras;
+                remaining.erase(remaining.begin() + i);
+                ReturnSynchronizedImages(remaining, images);
+                return {};
+            }
+        }
+
+        if (synchronized) {
+            return images;
+        }
+    }
+
+    ReturnSynchronizedImages(cameras, images);
+    return {};
+}
+
+void ReturnSynchronizedImages(const ICameraList &cameras, const std::vector<IImage> &images)
+{
+    for (size_t i = 0; i < images.size(); ++i) {
+        cameras[i]->ReturnImage(images[i]);
+    }
+}
+
+}
\ No newline at end of file
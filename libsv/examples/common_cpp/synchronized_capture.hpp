@@ -0,0 +1,17 @@
+#pragma once
+
+#include "sv/sv.h"
+#include <vector>
+
+namespace common
+{
+    /**
+     * Returns one image per camera, in camera list order, with all timestamps within
+     * toleranceUs of each other. Frames that fall behind are returned to their camera 
+     * and replaced by the next one. An empty list is returned if a camera fails to 
+     * deliver a valid image or no match is found, in which case no images are held.
+     */
+    std::vector<IImage> GetSynchronizedImages(const ICameraList &cameras, uint64_t toleranceUs);
+
+    void ReturnSynchronizedImages(const ICameraList &cameras, const std::vector<IImage> &images);
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "thread_util.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace common
+{
+
+bool SetThreadAffinity(std::thread &thread, const std::vector<int> &cpus)
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    return ::pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet) == 0;
+}
+
+/**
+ * Policy is one of SCHED_OTHER, SCHED_FIFO or SCHED_RR. Real-time policies usually
+ * require CAP_SYS_NICE or an appropriate RLIMIT_RTPRIO.
+ */
+bool SetThreadScheduling(std::thread &thread, int policy, int priority)
+{
+    sched_param parameters = {};
+    parameters.sched_priority = priority;
+
+    return ::pthread_setschedparam(thread.native_handle(), policy, &parameters) == 0;
+}
+
+/**
+ * Linux limits thread names to 15 characters, longer names are truncated.
+ */
+bool SetThreadName(std::thread &thread, const std::string &name)
+{
+    return ::pthread_setname_np(thread.native_handle(), name.substr(0, 15).c_str()) == 0;
+}
+
+pid_t GetCurrentThreadId()
+{
+    return ::syscall(SYS_gettid);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <sys/types.h>
+
+namespace common
+{
+    bool SetThreadAffinity(std::thread &thread, const std::vector<int> &cpus);
+    bool SetThreadScheduling(std::thread &thread, int policy, int priority);
+    bool SetThreadName(std::thread &thread, const std::string &name);
+    pid_t GetCurrentThreadId();
+}
\ No newline at end of file
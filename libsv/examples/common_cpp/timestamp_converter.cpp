@@ -0,0 +1,68 @@
+#include "timestamp_converter.hpp"
+
+#include <limits>
+
+namespace common
+{
+
+namespace
+{
+    constexpr int SYNCHRONIZATION_SAMPLES = 5;
+
+    int64_t ReadClockNs(clockid_t clock)
+    {
+        timespec time = {};
+        clock_gettime(clock, &time);
+        return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+    }
+}
+
+TimestampConverter::TimestampConverter(clockid_t clock) : clock(clock), offsetNs(0)
+{
+    Resynchronize();
+}
+
+TimestampConverter::~TimestampConverter()
+{
+
+}
+
+/**
+ * The target clock is read between two CLOCK_MONOTONIC reads and the sample with
+ * the narrowest window is used, which keeps preemption from skewing the offset.
+ */
+void TimestampConverter::Resynchronize()
+{
+    if (clock == CLOCK_MONOTONIC) {
+        offsetNs = 0;
+        return;
+    }
+
+    int64_t bestWindow = std::numeric_limits<int64_t>::max();
+    int64_t bestOffset = 0;
+
+    for (int i = 0; i < SYNCHRONIZATION_SAMPLES; ++i) {
+        int64_t before = ReadClockNs(CLOCK_MONOTONIC);
+        int64_t target = ReadClockNs(clock);
+        int64_t after = ReadClockNs(CLOCK_MONOTONIC);
+
+        if (after - before < bestWindow) {
+            bestWindow = after - before;
+            bestOffset = target - (before + (after - before) / 2);
+        }
+    }
+
+    offsetNs = bestOffset;
+}
+
+uint64_t TimestampConverter::Convert(const Timestamp &timestamp) const
+{
+    return ToNanoseconds(timestamp) + offsetNs;
+}
+
+uint64_t TimestampConverter::ToNanoseconds(const Timestamp &timestamp)
+{
+    return timestamp.s * 1000000000 + timestamp.us * 1000;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "sv/sv.h"
+#include <atomic>
+#include <ctime>
+
+namespace common
+{
+    /**
+     * Converts libsv image timestamps, which are taken from CLOCK_MONOTONIC, into 
+     * nanoseconds of another clock domain (e.g. CLOCK_REALTIME, CLOCK_MONOTONIC_RAW).
+     * The offset between the clocks is measured once, so each conversion is a single addition.
+     * Resynchronize() should be called periodically for clocks that are slewed by NTP.
+     */
+    class TimestampConverter
+    {
+        public:
+            explicit TimestampConverter(clockid_t clock = CLOCK_MONOTONIC);
+            ~TimestampConverter();
+            void Resynchronize();
+            uint64_t Convert(const Timestamp &timestamp) const;
+            static uint64_t ToNanoseconds(const Timestamp &timestamp);
+
+        private:
+            clockid_t clock;
+            std::atomic<int64_t> offsetNs;
+    };
+}
\ No newline at end of file
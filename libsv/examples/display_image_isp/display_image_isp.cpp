@@ -28,8 +28,8 @@ int main() try
     auto controls = camera->GetControls(); 
     for(uint i = 0; i < controls.size(); i++) {
 		v4l2isp::SelectNewValue(&controls[i]);
-		camera->SetControl(controls[i]);
 	}
+    camera->SetControls(controls);
 		
 	uint32_t frameRate = v4l2isp::SelectFrameRate();
 	camera->SetFrameRate(frameRate);
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <iomanip>
+#include <map>
 #include "v4l2isp/common.hpp"
 #include "libv4l2.h"
 #include "common_cpp/common.hpp"
@@ -87,6 +88,59 @@ namespace v4l2isp
 		}
 	}
 	
+	/**
+	 * Controls of the same class are applied with a single VIDIOC_S_EXT_CTRLS, one call per class.
+	 * Invalid values are rejected before anything in that call is applied (error_idx == count),
+	 * but a failure while applying may leave the controls before error_idx set, and classes
+	 * applied by earlier calls stay set.
+	 */
+	void SetNewValues(const std::vector<Control> &updatedControls, int fd)
+	{
+		std::map<uint32_t, std::vector<size_t>> controlClasses;
+		for (size_t i = 0; i < updatedControls.size(); i++) {
+			controlClasses[V4L2_CTRL_ID2CLASS(updatedControls[i].id)].push_back(i);
+		}
+		
+		bool classesApplied = false;
+		for (const auto &controlClass : controlClasses) {
+			std::vector<struct v4l2_ext_control> controls(controlClass.second.size());
+			std::vector<RangeFloat> ranges(controlClass.second.size());
+			struct v4l2_ext_controls ctrls = {};
+			
+			for (size_t i = 0; i < controlClass.second.size(); i++) {
+				const Control &updatedControl = updatedControls[controlClass.second[i]];
+				ranges[i].min = (float)updatedControl.min;
+				ranges[i].max = (float)updatedControl.max;
+				controls[i].id = updatedControl.id;
+				controls[i].string = (char *)&ranges[i];
+			}
+			
+			ctrls.count = controls.size();
+			ctrls.controls = controls.data();
+			ctrls.ctrl_class = controlClass.first;
+			// not every driver or libv4l2 plugin reports error_idx, so an unset one is detectable
+			ctrls.error_idx = UINT32_MAX;
+			
+			if(v4l2_ioctl(fd, VIDIOC_S_EXT_CTRLS, &ctrls)){
+				std::string applied = classesApplied ? ", controls of other classes were already set" : "";
+				if (ctrls.error_idx == ctrls.count) {
+					throw std::runtime_error("Failed to validate controls, none of this class were set" + applied);
+				}
+				if (ctrls.error_idx < ctrls.count) {
+					throw std::runtime_error("Failed to set control " + updatedControls[controlClass.second[ctrls.error_idx]].name + 
+						", controls before it may already be set" + applied);
+				}
+				throw std::runtime_error("Failed to set controls, some of them may already be set" + applied);
+			}
+			classesApplied = true;
+		}
+		
+		for (const auto &updatedControl : updatedControls) {
+			std::cout << SetControlString(updatedControl.name, updatedControl.min, updatedControl.max, std::string(" set to ")) << std::endl;
+		}
+		std::cout << std::endl;
+	}
+	
 	std::string SetControlString(std::string ctrlName, uint32_t min, uint32_t max, std::string opt){
 		return ctrlName + opt +  "[" + std::to_string(min) +  ", " + std::to_string(max) + "]";
 	}
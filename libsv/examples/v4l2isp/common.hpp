@@ -14,6 +14,8 @@ namespace v4l2isp
 	
 	void SetNewValue(Control updatedControl, int fd);
 	
+	void SetNewValues(const std::vector<Control> &updatedControls, int fd);
+	
 	std::string SetControlString(std::string ctrlName, uint32_t min, uint32_t max, std::string opt = "");
 	
     std::shared_ptr<Camera> SelectCamera(const std::vector<std::string> &cameras);
@@ -39,7 +39,7 @@ Camera::Camera(std::string node)
  : name(node), 
   bufferType(V4L2_BUF_TYPE_VIDEO_CAPTURE_MPLANE), memoryType(V4L2_MEMORY_DMABUF),
   width(1920), height(1080), pixelformat(V4L2_PIX_FMT_NV12M),
-  formatSet(false)
+  formatSet(false), dmabuffers_fd(), numOfBuffers(0), externalBuffers(false), externalBuffersSize(), externalBuffersPixelformat(0), buffersAllocated(false), mappedSurfaces()
 {
     /**
      * v4l2_open prints available modes when executed
@@ -67,15 +67,17 @@ Camera::Camera(std::string node)
 		throw std::runtime_error("Device does not support V4L2_CAP_VIDEO_CAPTURE_MPLANE");
 	}
     driverName = reinterpret_cast<char*>(capabilities.card);
-
-    nvbuf_surf = new NvBufSurface();
 }
 
 
 Camera::~Camera()
 {
+    // buffers cannot be released while the stream is still on
+    if (buffersAllocated) {
+        ::v4l2_ioctl(fd, VIDIOC_STREAMOFF, &bufferType);
+    }
+    ReleaseBuffers();
 	::v4l2_close(fd);
-    delete nvbuf_surf;
 }
 
 std::string Camera::GetName()
@@ -104,6 +106,7 @@ std::vector<uint32_t> Camera::GetPixelformats()
 void Camera::SetPixelformat(uint32_t pixelformat)
 {
     this->pixelformat = pixelformat;
+    formatSet = false;
 }
 
 void Camera::SetFrameSize(const FrameSize& frameSize)
@@ -113,8 +116,38 @@ void Camera::SetFrameSize(const FrameSize& frameSize)
     SetFormat();
 }
 
+void Camera::SetBuffers(const std::vector<int32_t> &dmabufFds)
+{
+    if (dmabufFds.empty() || dmabufFds.size() > MAX_CAPTURE_BUFFFERS) {
+        throw std::invalid_argument("Invalid number of capture buffers");
+    }
+
+    if (!ReleaseBuffers()) {
+        throw std::runtime_error("Failed to release buffers");
+    }
+
+    std::fill(std::begin(dmabuffers_fd), std::end(dmabuffers_fd), 0);
+    std::copy(dmabufFds.begin(), dmabufFds.end(), dmabuffers_fd);
+    numOfBuffers = dmabufFds.size();
+    externalBuffers = true;
+    externalBuffersSize = {width, height};
+    externalBuffersPixelformat = pixelformat;
+}
+
 void Camera::SetFormat()
 {
+    if (!ReleaseBuffers()) {
+        throw std::runtime_error("Failed to release buffers");
+    }
+
+    // caller buffers are sized for the format they were set with
+    if (externalBuffers && (externalBuffersSize.width != width || externalBuffersSize.height != height || 
+        externalBuffersPixelformat != pixelformat)) {
+        std::fill(std::begin(dmabuffers_fd), std::end(dmabuffers_fd), 0);
+        numOfBuffers = 0;
+        externalBuffers = false;
+    }
+
     struct v4l2_format format {};
     format.type = bufferType;
     format.fmt.pix_mp.width = width;
@@ -128,24 +161,24 @@ void Camera::SetFormat()
     formatSet = true;
 }
 
-void Camera::StartStream()
+void Camera::AllocateBuffers()
 {
-	if (!formatSet) {
-        SetFormat();
-    }
-	
 	v4l2_requestbuffers reqbuffers = {};
-	reqbuffers.count = MAX_CAPTURE_BUFFFERS;
+	reqbuffers.count = externalBuffers ? numOfBuffers : MAX_CAPTURE_BUFFFERS;
     reqbuffers.memory = memoryType;
     reqbuffers.type = bufferType;
     
     if (v4l2_ioctl (fd, VIDIOC_REQBUFS, &reqbuffers)) {
         throw std::runtime_error("Failed to get dma buffers");
     }
+
+    if (externalBuffers && reqbuffers.count != numOfBuffers) {
+        throw std::runtime_error("Driver did not accept all external buffers");
+    }
 	
     NvBufSurfaceAllocateParams cParams = {};
 
-    if (reqbuffers.count) {
+    if (!externalBuffers) {
         for (uint32_t i = 0; i < reqbuffers.count; i++) {
             cParams.params.width = width;
             cParams.params.height = height;
@@ -154,27 +187,17 @@ void Camera::StartStream()
             cParams.params.memType = NVBUF_MEM_SURFACE_ARRAY;
             cParams.memtag = NvBufSurfaceTag_CAMERA;
             
-            if (NvBufSurfaceAllocate(&nvbuf_surf, 1, &cParams) != 0) {
-                std::cout << "Failed to create NvBufSurface!\n";
-            }
-            nvbuf_surf->numFilled = 1;
-            dmabuffers_fd[i] = nvbuf_surf->surfaceList[0].bufferDesc;
-        }
-    } else {
-        for (uint32_t i = 0; i < MAX_CAPTURE_BUFFFERS; i++) {
-            if (dmabuffers_fd[i]) {
-                if (NvBufSurfaceFromFd((int)dmabuffers_fd[i], (void**)(&nvbuf_surf)) != 0) {
-                    std::cout << "Failed to get NvBufSurface from FD\n";
-                }
-                if (NvBufSurfaceDestroy(nvbuf_surf) != 0) {
-                    std::cout << "Failed to destroy NvBufSurface!\n";
-                }
-                dmabuffers_fd[i] = 0;
+            NvBufSurface *surface = nullptr;
+            if (NvBufSurfaceAllocate(&surface, 1, &cParams) != 0) {
+                throw std::runtime_error("Failed to create NvBufSurface");
             }
+            surface->numFilled = 1;
+            dmabuffers_fd[i] = surface->surfaceList[0].bufferDesc;
         }
     }
 
 	numOfBuffers = reqbuffers.count;
+    buffersAllocated = true;
 
     struct v4l2_plane captureplanes[NV12_PLANES];
 	for (uint32_t i = 0; i < numOfBuffers; ++i) {
@@ -190,26 +213,65 @@ void Camera::StartStream()
 					throw std::runtime_error("Failed to query buffers");
 			}
         }
+}
+
+bool Camera::ReleaseBuffers()
+{
+    if (!buffersAllocated) {
+        return true;
+    }
+
+    struct v4l2_requestbuffers requestBuffers {};
+    requestBuffers.type = bufferType;
+    requestBuffers.memory = memoryType;
+    requestBuffers.count = 0;
+    if (::v4l2_ioctl(fd, VIDIOC_REQBUFS, &requestBuffers) == -1) {
+        return false;
+    }
+    buffersAllocated = false;
+
+    UnmapBuffers();
+
+    if (externalBuffers) {
+        return true;
+    }
+
+    for (uint32_t i = 0; i < MAX_CAPTURE_BUFFFERS; i++) {
+        if (dmabuffers_fd[i]) {
+            NvBufSurface *surface = nullptr;
+            if (NvBufSurfaceFromFd((int)dmabuffers_fd[i], (void**)(&surface)) != 0) {
+                std::cout << "Failed to get NvBufSurface from FD\n";
+            } else if (NvBufSurfaceDestroy(surface) != 0) {
+                std::cout << "Failed to destroy NvBufSurface!\n";
+            }
+            dmabuffers_fd[i] = 0;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Buffers stay allocated and registered with the driver between StopStream()
+ * and StartStream(), so restarting with an unchanged format only needs to
+ * queue them again. They are released when the format or buffers change.
+ */
+void Camera::StartStream()
+{
+	if (!formatSet) {
+        SetFormat();
+    }
+
+    if (!buffersAllocated) {
+        AllocateBuffers();
+    }
 	
 	if(v4l2_ioctl (fd, VIDIOC_STREAMON, &bufferType)) {
 			throw std::runtime_error("Failed to start stream");
 	}
 
 	for (uint32_t i = 0; i < numOfBuffers; ++i) {
-		struct v4l2_buffer queue_cap_v4l2_buf = {};
-        struct v4l2_plane queue_cap_planes[2] = {};
-
-        queue_cap_v4l2_buf.index = i;
-        queue_cap_v4l2_buf.m.planes = queue_cap_planes;
-        queue_cap_v4l2_buf.m.planes[0].m.fd = dmabuffers_fd[i];
-		
-		queue_cap_v4l2_buf.type = bufferType;
-		queue_cap_v4l2_buf.memory = memoryType;
-		queue_cap_v4l2_buf.length = 2;
-
-		if(v4l2_ioctl (fd, VIDIOC_QBUF, &queue_cap_v4l2_buf)) {
-			throw std::runtime_error("Failed to enqueue buffer");
-		}
+        QueueBuffer(i);
 	} 		
 }
 
@@ -219,15 +281,6 @@ void Camera::StopStream()
     if (result == -1) {
         throw std::runtime_error("Failed to stop stream");
     }
-
-    struct v4l2_requestbuffers requestBuffers {};
-    requestBuffers.type = bufferType;
-    requestBuffers.memory = memoryType;
-    requestBuffers.count = 0;
-    result = ::v4l2_ioctl(fd, VIDIOC_REQBUFS, &requestBuffers);
-    if (result == -1) {
-        throw std::runtime_error("Failed to request 0 buffers");
-    }
 }
 
 Image* Camera::GetImage()
@@ -240,10 +293,23 @@ Image* Camera::GetImage()
 	v4l2_buf.type = bufferType;
 	v4l2_buf.memory = memoryType;
 
-	auto result = v4l2_ioctl (fd, VIDIOC_DQBUF, &v4l2_buf);
-	if(result) {
-			throw std::runtime_error("Failed to dequeue buffer");
-	}		
+    /**
+     * Buffers flagged with V4L2_BUF_FLAG_ERROR may not be completely filled.
+     * They are queued back right away, so torn frames are skipped without
+     * holding every frame until the next one arrives.
+     */
+    while (true) {
+        auto result = v4l2_ioctl (fd, VIDIOC_DQBUF, &v4l2_buf);
+        if(result) {
+            throw std::runtime_error("Failed to dequeue buffer");
+        }
+
+        if (!(v4l2_buf.flags & V4L2_BUF_FLAG_ERROR)) {
+            break;
+        }
+
+        QueueBuffer(v4l2_buf.index);
+    }
 
     int dmabuf_fd = v4l2_buf.m.planes[0].m.fd;
 
@@ -251,36 +317,73 @@ Image* Camera::GetImage()
 		throw std::runtime_error("dmabuf_fd <= 0");
 	}
 	
-    int plane = 0;
-
-    if (NvBufSurfaceFromFd(dmabuf_fd, (void**)(&nvbuf_surf))) {
-        throw std::runtime_error("Failed at NvBufSurfaceFromFd!\n");
-    }
+    NvBufSurface *surface = MapBuffer(v4l2_buf.index, dmabuf_fd);
 
-    if (!NvBufSurfaceMap(nvbuf_surf, 0, plane, NVBUF_MAP_READ_WRITE)) {    
-        dataY = (void*)nvbuf_surf->surfaceList[0].mappedAddr.addr[plane];
-        NvBufSurfaceSyncForCpu(nvbuf_surf, 0, plane);
-        image.strideY = nvbuf_surf->surfaceList[0].planeParams.pitch[plane];
-        image.planeY = (char*)dataY;
-    }
+    int plane = 0;
+    dataY = (void*)surface->surfaceList[0].mappedAddr.addr[plane];
+    NvBufSurfaceSyncForCpu(surface, 0, plane);
+    image.strideY = surface->surfaceList[0].planeParams.pitch[plane];
+    image.planeY = (char*)dataY;
 
     plane = 1;
-    if (!NvBufSurfaceMap(nvbuf_surf, 0, plane, NVBUF_MAP_READ_WRITE)) {    
-        dataUV = (void*)nvbuf_surf->surfaceList[0].mappedAddr.addr[plane];
-        NvBufSurfaceSyncForCpu(nvbuf_surf, 0, plane);
-        image.strideUV = nvbuf_surf->surfaceList[0].planeParams.pitch[plane];
-        image.planeUV = (char*)dataUV;
-    }
+    dataUV = (void*)surface->surfaceList[0].mappedAddr.addr[plane];
+    NvBufSurfaceSyncForCpu(surface, 0, plane);
+    image.strideUV = surface->surfaceList[0].planeParams.pitch[plane];
+    image.planeUV = (char*)dataUV;
  
     image.index = v4l2_buf.index; 
+    image.dmabufFd = dmabuf_fd;
     
     return &image;   
 }
 
 void Camera::ReturnImage()
 {
-    NvBufSurfaceUnMap(nvbuf_surf, 0, 0);
-    NvBufSurfaceUnMap(nvbuf_surf, 0, 1);
+    QueueBuffer(image.index);
+}
+
+/**
+ * Buffers are mapped for CPU access the first time they are dequeued and stay
+ * mapped until they are released. Only the cache sync is done per frame.
+ * The mapping is read-only, so no sync for device is needed when a buffer is queued back.
+ */
+NvBufSurface *Camera::MapBuffer(uint32_t index, int32_t dmabufFd)
+{
+    if (index >= MAX_CAPTURE_BUFFFERS) {
+        throw std::runtime_error("Invalid buffer index");
+    }
+
+    if (mappedSurfaces[index]) {
+        return mappedSurfaces[index];
+    }
+
+    NvBufSurface *surface = nullptr;
+    if (NvBufSurfaceFromFd(dmabufFd, (void**)(&surface))) {
+        throw std::runtime_error("Failed at NvBufSurfaceFromFd!\n");
+    }
+
+    for (int plane = 0; plane < NV12_PLANES; plane++) {
+        if (NvBufSurfaceMap(surface, 0, plane, NVBUF_MAP_READ)) {
+            throw std::runtime_error("Failed to map NvBufSurface");
+        }
+    }
+
+    mappedSurfaces[index] = surface;
+    return surface;
+}
+
+void Camera::UnmapBuffers()
+{
+    for (uint32_t i = 0; i < MAX_CAPTURE_BUFFFERS; i++) {
+        if (mappedSurfaces[i]) {
+            NvBufSurfaceUnMap(mappedSurfaces[i], 0, -1);
+            mappedSurfaces[i] = nullptr;
+        }
+    }
+}
+
+void Camera::QueueBuffer(uint32_t index)
+{
 	v4l2_buffer buffer = {};
 	v4l2_plane planes[NV12_PLANES] = {};
 	
@@ -288,8 +391,8 @@ void Camera::ReturnImage()
 	buffer.memory = memoryType;
 	buffer.length = NV12_PLANES;
 	buffer.m.planes = planes;
-	buffer.m.planes[0].m.fd = dmabuffers_fd[image.index];
-	buffer.index = image.index;
+	buffer.m.planes[0].m.fd = dmabuffers_fd[index];
+	buffer.index = index;
 	
 	if(v4l2_ioctl (fd, VIDIOC_QBUF, &buffer)) {
 		throw std::runtime_error("Failed to enqueue buffer");
@@ -317,6 +420,11 @@ void Camera::SetControl(Control control)
 	v4l2isp::SetNewValue(control, fd);
 }
 
+void Camera::SetControls(const std::vector<Control> &controls)
+{
+	v4l2isp::SetNewValues(controls, fd);
+}
+
 void Camera::SetFrameRate(uint32_t framerate)
 {
 	SetSensorMode(sensorMode);
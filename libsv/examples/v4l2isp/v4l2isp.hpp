@@ -40,6 +40,7 @@ namespace v4l2isp
 		uint32_t strideUV;
 		char *planeY;
 		char *planeUV;
+		int32_t dmabufFd;
 	};
 			
 
@@ -53,19 +54,39 @@ namespace v4l2isp
             std::vector<uint32_t> GetPixelformats();
             void SetPixelformat(uint32_t pixelformat);
             void SetFrameSize(const FrameSize& frameSize);
+            /**
+             * Capture into caller-owned NvBufSurface dmabufs instead of
+             * buffers allocated by the camera. Ownership stays with the caller.
+             * Changing the frame size or pixel format afterwards drops them, 
+             * so buffers for the new format have to be set again.
+             */
+            void SetBuffers(const std::vector<int32_t> &dmabufFds);
             void StartStream();
             void StopStream();
+            /**
+             * Image planes are mapped read-only and stay valid until ReturnImage().
+             */
             Image *GetImage(); 
             void ReturnImage();             
             uint32_t GetWidth();
             uint32_t GetHeight();      
             std::vector<Control> GetControls();
             void SetControl(Control control);
+            /**
+             * Apply the controls with one VIDIOC_S_EXT_CTRLS call per control class.
+             * On failure some of them may already be applied, see SetNewValues().
+             */
+            void SetControls(const std::vector<Control> &controls);
             void SetFrameRate(uint32_t framerate);
             FrameSize SelectFrameSize();
               
 		private:
             void SetFormat();
+            void AllocateBuffers();
+            bool ReleaseBuffers();
+            void QueueBuffer(uint32_t index);
+            NvBufSurface *MapBuffer(uint32_t index, int32_t dmabufFd);
+            void UnmapBuffers();
             void GetSensorModes(int pipeID);
             void SetSensorMode(uint32_t sensorMode);
             int32_t fd;
@@ -79,7 +100,11 @@ namespace v4l2isp
             std::vector <Control> controls;
             int32_t dmabuffers_fd[MAX_CAPTURE_BUFFFERS];
             uint32_t numOfBuffers;
-            NvBufSurface *nvbuf_surf;
+            bool externalBuffers;
+            FrameSize externalBuffersSize;
+            uint32_t externalBuffersPixelformat;
+            bool buffersAllocated;
+            NvBufSurface *mappedSurfaces[MAX_CAPTURE_BUFFFERS];
 			void *dataY;
 			void *dataUV;
 			std::vector<SensorMode> sensorModes;